@@ -1,10 +1,14 @@
 ﻿#include "DLSS.h"
+#include "DLSSBenchmark.h"
 #include "DLSSPostFx.h"
+#include "DLSSReactiveMask.h"
 #include "DLSSSettings.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Core/Config/GameSettings.h"
 #include "Engine/Content/Content.h"
 #include "Engine/Content/JsonAsset.h"
+#include "Engine/Engine/Engine.h"
+#include "Engine/Graphics/GPUDevice.h"
 #include "Engine/Graphics/RenderTask.h"
 #include "Engine/Profiler/ProfilerCPU.h"
 
@@ -49,6 +53,147 @@ void DLSS::QueryRecommendedSettings(const Int2& displaySize, DLSSRecommendedSett
     _ngx.QueryRecommendedSettings(displaySize, result, quality);
 }
 
+const DLSSRenderTaskPolicy& DLSS::GetRenderTaskPolicy() const
+{
+    return _renderTaskPolicy;
+}
+
+void DLSS::SetRenderTaskPolicy(const DLSSRenderTaskPolicy& value)
+{
+    _renderTaskPolicy = value;
+    _renderTaskPolicyVersion++;
+}
+
+DLSSRenderTaskMode DLSS::GetRenderTaskOverride(SceneRenderTask* task) const
+{
+    const RenderTaskState* state = _renderTasks.TryGet(task);
+    return state ? state->Mode : DLSSRenderTaskMode::Default;
+}
+
+void DLSS::SetRenderTaskOverride(SceneRenderTask* task, DLSSRenderTaskMode mode)
+{
+    if (!task)
+        return;
+    RenderTaskState& state = GetRenderTaskState(task);
+    state.Mode = mode;
+    state.PolicyVersion = 0;
+}
+
+bool DLSS::IsRenderTaskEnabled(SceneRenderTask* task)
+{
+    if (!task)
+        return false;
+
+    // Benchmark uses DLSS exclusively (other views would add to the measured time and memory)
+    if (_benchmark)
+        return task == _benchmark->GetTask();
+    RenderTaskState& state = GetRenderTaskState(task);
+    const Float2 outputSize = task->GetOutputViewport().Size;
+    if (state.PolicyVersion == _renderTaskPolicyVersion && state.OutputSize == outputSize)
+        return state.Enabled;
+
+    // Evaluate policy for this task
+    state.PolicyVersion = _renderTaskPolicyVersion;
+    state.OutputSize = outputSize;
+    if (state.Mode != DLSSRenderTaskMode::Default)
+    {
+        state.Enabled = state.Mode == DLSSRenderTaskMode::Enabled;
+        return state.Enabled;
+    }
+    DLSSRenderTaskTypes type;
+    if (task->View.IsSingleFrame)
+        type = DLSSRenderTaskTypes::SingleFrame;
+    else if (task->View.IsOfflinePass)
+        type = DLSSRenderTaskTypes::Offline;
+    else if (task == MainRenderTask::Instance)
+        type = DLSSRenderTaskTypes::Main;
+    else
+        type = DLSSRenderTaskTypes::Custom;
+    state.Enabled = EnumHasAnyFlags(_renderTaskPolicy.Types, type) &&
+            outputSize.X >= (float)_renderTaskPolicy.MinOutputSize.X &&
+            outputSize.Y >= (float)_renderTaskPolicy.MinOutputSize.Y;
+    return state.Enabled;
+}
+
+bool DLSS::StartBenchmark(const DLSSBenchmarkSettings& settings)
+{
+    if (_benchmark)
+    {
+        LOG(Warning, "DLSS benchmark is already running.");
+        return true;
+    }
+
+    // Use stand-in backend if requested or when running without GPU
+    if (settings.UseStandIn || GPUDevice::Instance->GetRendererType() == RendererType::Null)
+    {
+        _delayInit = false;
+        _ngx.Shutdown();
+        _ngx.InitializeStandIn(_support);
+    }
+    else if (GetSupport() != DLSSSupport::Supported)
+    {
+        LOG(Warning, "DLSS benchmark requires DLSS support.");
+        return true;
+    }
+
+    _benchmark = New<DLSSBenchmark>(this, settings);
+    Engine::Update.Bind<DLSS, &DLSS::OnUpdate>(this);
+    return false;
+}
+
+bool DLSS::IsBenchmarkRunning() const
+{
+    return _benchmark != nullptr;
+}
+
+void DLSS::StopBenchmark()
+{
+    if (!_benchmark)
+        return;
+    Engine::Update.Unbind<DLSS, &DLSS::OnUpdate>(this);
+    Delete(_benchmark);
+    _benchmark = nullptr;
+
+    // Go back to the NGX backend
+    if (_ngx.IsStandIn())
+    {
+        _ngx.Shutdown();
+        _support = DLSSSupport::NotSupported;
+        _delayInit = true;
+    }
+}
+
+void DLSS::OnUpdate()
+{
+    _benchmark->Update();
+    if (_benchmark->IsDone())
+    {
+        const bool exit = _benchmark->GetSettings().ExitOnEnd;
+        const int32 exitCode = _benchmark->HasFailed() ? 1 : 0;
+        StopBenchmark();
+        if (exit)
+            Engine::RequestExit(exitCode);
+    }
+}
+
+DLSS::RenderTaskState& DLSS::GetRenderTaskState(SceneRenderTask* task)
+{
+    RenderTaskState* state = _renderTasks.TryGet(task);
+    if (!state)
+    {
+        // Remove cached state when task gets deleted (its address can be reused by a new task)
+        task->Deleted.Bind<DLSS, &DLSS::OnRenderTaskDeleted>(this);
+        state = &_renderTasks[task];
+    }
+    return *state;
+}
+
+void DLSS::OnRenderTaskDeleted(ScriptingObject* obj)
+{
+    _renderTasks.Remove((SceneRenderTask*)obj);
+    _ngx.ReleaseFeature((SceneRenderTask*)obj);
+}
+
 void DLSS::DelayInit()
 {
     PROFILE_CPU();
@@ -69,23 +214,43 @@ void DLSS::Initialize()
     // TODO: apply global mip bias to texture groups samplers to increase texturing quality
     PostFx = New<DLSSPostFx>();
     SceneRenderTask::AddGlobalCustomPostFx(PostFx);
+    ReactiveMaskPostFx = New<DLSSReactiveMaskPostFx>();
+    SceneRenderTask::AddGlobalCustomPostFx(ReactiveMaskPostFx);
 
     const auto settings = DLSSSettings::Get();
     _support = DLSSSupport::NotSupported;
     _delayInit = settings->LazyInit;
-    if (_delayInit)
-        return;
-    DelayInit();
+    if (!_delayInit)
+        DelayInit();
+
+#if DLSS_BENCHMARK
+    // Benchmark build runs the sweep on startup
+    DLSSBenchmarkSettings benchmarkSettings;
+    benchmarkSettings.ExitOnEnd = true;
+    if (StartBenchmark(benchmarkSettings))
+        Engine::RequestExit(1);
+#endif
 }
 
 void DLSS::Deinitialize()
 {
+    StopBenchmark();
     if (PostFx)
     {
         SceneRenderTask::RemoveGlobalCustomPostFx(PostFx);
         PostFx->DeleteObject();
         PostFx = nullptr;
     }
+    if (ReactiveMaskPostFx)
+    {
+        SceneRenderTask::RemoveGlobalCustomPostFx(ReactiveMaskPostFx);
+        ReactiveMaskPostFx->Dispose();
+        ReactiveMaskPostFx->DeleteObject();
+        ReactiveMaskPostFx = nullptr;
+    }
+    for (auto& e : _renderTasks)
+        e.Key->Deleted.Unbind<DLSS, &DLSS::OnRenderTaskDeleted>(this);
+    _renderTasks.Clear();
     _ngx.Shutdown();
 
     GamePlugin::Deinitialize();
@@ -1,10 +1,13 @@
 ﻿#pragma once
 
 #include "Engine/Scripting/Plugins/GamePlugin.h"
+#include "Engine/Core/Collections/Dictionary.h"
 #include "Types.h"
 #include "NGXWrapper.h"
 
 class DLSSPostFx;
+class DLSSReactiveMaskPostFx;
+class DLSSBenchmark;
 
 /// <summary>
 /// DLSS plugin.
@@ -12,12 +15,25 @@ class DLSSPostFx;
 API_CLASS(Namespace="NVIDIA") class DLSS_API DLSS : public GamePlugin
 {
     friend DLSSPostFx;
+    friend DLSSBenchmark;
     DECLARE_SCRIPTING_TYPE(DLSS);
 
 private:
+    struct RenderTaskState
+    {
+        DLSSRenderTaskMode Mode = DLSSRenderTaskMode::Default;
+        uint32 PolicyVersion = 0;
+        Float2 OutputSize = Float2::Zero;
+        bool Enabled = false;
+    };
+
     NGXWrapper _ngx;
     DLSSSupport _support = DLSSSupport::NotSupported;
     bool _delayInit = false;
+    DLSSBenchmark* _benchmark = nullptr;
+    DLSSRenderTaskPolicy _renderTaskPolicy;
+    uint32 _renderTaskPolicyVersion = 1;
+    Dictionary<SceneRenderTask*, RenderTaskState> _renderTasks;
 
 public:
     /// <summary>
@@ -25,6 +41,11 @@ public:
     /// </summary>
     API_FIELD(ReadOnly) DLSSPostFx* PostFx = nullptr;
 
+    /// <summary>
+    /// DLSS reactive mask effect (captures opaque scene color before forward pass).
+    /// </summary>
+    API_FIELD(ReadOnly) DLSSReactiveMaskPostFx* ReactiveMaskPostFx = nullptr;
+
     /// <summary>
     /// DLSS support information.
     /// </summary>
@@ -40,6 +61,31 @@ public:
     /// </summary>
     API_FIELD() float Sharpness = 0.0f;
 
+    /// <summary>
+    /// If checked, DLSS will use reactive mask generated from transparent geometry (eg. particles, emissive VFX, forward-shaded materials) to bias the output towards the current frame color and reduce ghosting. Costs a render-resolution scene color copy and a fullscreen pass per frame.
+    /// </summary>
+    API_FIELD() bool ReactiveMask = false;
+
+    /// <summary>
+    /// Reactive mask intensity scale. Higher values make transparent pixels rely more on the current frame color (fully reactive pixels get no temporal accumulation, so keep it low for large forward-shaded surfaces such as glass or water).
+    /// </summary>
+    API_FIELD() float ReactiveMaskScale = 1.0f;
+
+    /// <summary>
+    /// Minimum color difference (after tonemapping) between opaque and final scene color for the pixel to be considered as reactive. Higher values ignore subtle transparent surfaces.
+    /// </summary>
+    API_FIELD() float ReactiveMaskThreshold = 0.05f;
+
+    /// <summary>
+    /// Motion vectors and depth buffer description. Changing it recreates the DLSS feature.
+    /// </summary>
+    API_FIELD() DLSSMotionVectorsFlags MotionVectorsFlags = DLSSMotionVectorsFlags::None;
+
+    /// <summary>
+    /// Custom motion vectors texture to use instead of the engine motion vectors (eg. existing velocity buffer rendered by the game). Values should be in normalized UV space. Used only by the render tasks for which its size matches MotionVectorsFlags (render resolution, or output resolution with DisplayResolution flag), other tasks use the engine motion vectors.
+    /// </summary>
+    API_FIELD() GPUTexture* MotionVectors = nullptr;
+
     /// <summary>
     /// Calculates the optimal settings for the rendering into the certain display resolution at given quality.
     /// </summary>
@@ -54,8 +100,55 @@ public:
     /// <param name="quality">DLSS quality, MAX to use current setting.</param>
     API_FUNCTION() void QueryRecommendedSettings(API_PARAM(ref) const Int2& displaySize, API_PARAM(Out) DLSSRecommendedSettings& result, DLSSQuality quality = DLSSQuality::MAX);
 
+    /// <summary>
+    /// Gets the render task policy that decides which render tasks can use DLSS.
+    /// </summary>
+    API_PROPERTY() const DLSSRenderTaskPolicy& GetRenderTaskPolicy() const;
+
+    /// <summary>
+    /// Sets the render task policy that decides which render tasks can use DLSS.
+    /// </summary>
+    API_PROPERTY() void SetRenderTaskPolicy(API_PARAM(ref) const DLSSRenderTaskPolicy& value);
+
+    /// <summary>
+    /// Gets the DLSS usage mode override for the given render task.
+    /// </summary>
+    /// <param name="task">The render task.</param>
+    /// <returns>The usage mode.</returns>
+    API_FUNCTION() DLSSRenderTaskMode GetRenderTaskOverride(SceneRenderTask* task) const;
+
+    /// <summary>
+    /// Sets the DLSS usage mode override for the given render task (eg. to force disable DLSS for a render-to-texture camera).
+    /// </summary>
+    /// <param name="task">The render task.</param>
+    /// <param name="mode">The usage mode.</param>
+    API_FUNCTION() void SetRenderTaskOverride(SceneRenderTask* task, DLSSRenderTaskMode mode);
+
+    /// <summary>
+    /// Checks if the given render task can use DLSS (based on the render task policy and overrides). Result is cached per-task until the policy or task output size changes.
+    /// </summary>
+    /// <param name="task">The render task.</param>
+    /// <returns>True if DLSS can be used by the render task, otherwise false.</returns>
+    API_FUNCTION() bool IsRenderTaskEnabled(SceneRenderTask* task);
+
+    /// <summary>
+    /// Starts the benchmark that renders every quality mode at every output resolution (using a fixed camera path) and saves per-frame timings and memory usage to CSV and JSON files.
+    /// </summary>
+    /// <param name="settings">Benchmark settings.</param>
+    /// <returns>True if failed to start benchmark, otherwise false.</returns>
+    API_FUNCTION() bool StartBenchmark(API_PARAM(ref) const DLSSBenchmarkSettings& settings);
+
+    /// <summary>
+    /// Checks if benchmark is running.
+    /// </summary>
+    API_PROPERTY() bool IsBenchmarkRunning() const;
+
 private:
     void DelayInit();
+    void StopBenchmark();
+    void OnUpdate();
+    RenderTaskState& GetRenderTaskState(SceneRenderTask* task);
+    void OnRenderTaskDeleted(ScriptingObject* obj);
 
 public:
     // [GamePlugin]
@@ -0,0 +1,505 @@
+﻿#include "DLSSBenchmark.h"
+#include "DLSS.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Core/Types/StringBuilder.h"
+#include "Engine/Engine/Time.h"
+#include "Engine/Engine/Globals.h"
+#include "Engine/Platform/File.h"
+#include "Engine/Graphics/Graphics.h"
+#include "Engine/Graphics/GPUDevice.h"
+#include "Engine/Graphics/GPUContext.h"
+#include "Engine/Graphics/GPUTimerQuery.h"
+#include "Engine/Graphics/RenderTask.h"
+#include "Engine/Graphics/Textures/GPUTexture.h"
+#include "Engine/Serialization/Json.h"
+#include "Engine/Serialization/JsonWriters.h"
+
+namespace
+{
+    const char* GetQualityName(DLSSQuality quality)
+    {
+        switch (quality)
+        {
+        case DLSSQuality::UltraPerformance:
+            return "UltraPerformance";
+        case DLSSQuality::Performance:
+            return "Performance";
+        case DLSSQuality::Balanced:
+            return "Balanced";
+        case DLSSQuality::Quality:
+            return "Quality";
+        case DLSSQuality::UltraQuality:
+            return "UltraQuality";
+        default:
+            return "";
+        }
+    }
+
+    float ToMB(uint64 bytes)
+    {
+        return (float)((double)bytes / (1024.0 * 1024.0));
+    }
+
+    void WriteSize(PrettyJsonWriter& writer, const Int2& size)
+    {
+        writer.StartObject();
+        writer.JKEY("X");
+        writer.Int(size.X);
+        writer.JKEY("Y");
+        writer.Int(size.Y);
+        writer.EndObject();
+    }
+}
+
+DLSSBenchmark::DLSSBenchmark(DLSS* dlss, const DLSSBenchmarkSettings& settings)
+    : _dlss(dlss)
+    , _settings(settings)
+{
+    _settings.WarmupFrames = Math::Max(_settings.WarmupFrames, 0);
+    _settings.Frames = Math::Max(_settings.Frames, 1);
+    if (_settings.Resolutions.IsEmpty())
+    {
+        _settings.Resolutions.Add(Int2(1280, 720));
+        _settings.Resolutions.Add(Int2(1920, 1080));
+        _settings.Resolutions.Add(Int2(2560, 1440));
+        _settings.Resolutions.Add(Int2(3840, 2160));
+    }
+    if (_settings.OutputPath.IsEmpty())
+        _settings.OutputPath = Globals::ProjectFolder / TEXT("DLSSBenchmark");
+    _prevQuality = dlss->Quality;
+    _prevSharpness = dlss->Sharpness;
+
+    // Build list of configurations to test
+    for (const Int2& displaySize : _settings.Resolutions)
+    {
+        if (displaySize.X <= 0 || displaySize.Y <= 0)
+            continue;
+        for (int32 quality = 0; quality < (int32)DLSSQuality::MAX; quality++)
+        {
+            Config config;
+            config.Quality = (DLSSQuality)quality;
+            config.DisplaySize = displaySize;
+            config.FeatureCreateTimeMs = 0.0f;
+            dlss->QueryRecommendedSettings(displaySize, config.Settings, config.Quality);
+
+            // NGX returns zero resolution for quality modes not supported at this size
+            if (config.Settings.ResolutionOptimal.X <= 0 || config.Settings.ResolutionOptimal.Y <= 0)
+            {
+                LOG(Info, "DLSS benchmark: {} at {}x{} is not supported, skipping", String(GetQualityName(config.Quality)), displaySize.X, displaySize.Y);
+                _unsupportedConfigs.Add({ config.Quality, displaySize });
+                continue;
+            }
+            _configs.Add(config);
+        }
+    }
+    _samples.EnsureCapacity(_configs.Count() * _settings.Frames);
+
+    // Give the previous DLSS feature time to be released so it doesn't count to the memory usage of the next configuration
+    _settings.WarmupFrames = Math::Max(_settings.WarmupFrames, NGX_FEATURE_RELEASE_LATENCY + 1);
+
+    // Setup rendering into the offscreen output of the tested size
+    _output = GPUDevice::Instance->CreateTexture(TEXT("DLSS.Benchmark"));
+    _task = New<SceneRenderTask>();
+    _task->Order = 100;
+    _task->Output = _output;
+    _task->Enabled = false;
+    if (GPUDevice::Instance->GetRendererType() == RendererType::Null)
+        _headlessInput = GPUDevice::Instance->CreateTexture(TEXT("DLSS.Benchmark.Input"));
+
+    // Uncap frame rate so the frame time reflects the tested configuration
+    _prevUpdateFPS = Time::UpdateFPS;
+    _prevDrawFPS = Time::DrawFPS;
+    _prevUseVSync = Graphics::UseVSync;
+    Time::UpdateFPS = 0.0f;
+    Time::DrawFPS = 0.0f;
+    Graphics::UseVSync = false;
+
+    // Disable main view (DLSS is used only by the benchmark task during the sweep)
+    if (MainRenderTask::Instance)
+    {
+        _prevMainTaskEnabled = MainRenderTask::Instance->Enabled;
+        MainRenderTask::Instance->Enabled = false;
+    }
+    LOG(Info, "Starting DLSS benchmark ({} configurations, {} frames each)", _configs.Count(), _settings.Frames);
+}
+
+DLSSBenchmark::~DLSSBenchmark()
+{
+    if (_camera && _camera.Get() != _ownedCamera)
+        _camera->SetTransform(_cameraTransform);
+    _camera = nullptr;
+    if (_ownedCamera)
+    {
+        _ownedCamera->DeleteObject();
+        _ownedCamera = nullptr;
+    }
+    _dlss->Quality = _prevQuality;
+    _dlss->Sharpness = _prevSharpness;
+    Time::UpdateFPS = _prevUpdateFPS;
+    Time::DrawFPS = _prevDrawFPS;
+    Graphics::UseVSync = _prevUseVSync;
+    if (MainRenderTask::Instance)
+        MainRenderTask::Instance->Enabled = _prevMainTaskEnabled;
+    if (_task)
+    {
+        _task->Enabled = false;
+        _task->Output = nullptr;
+        _task->DeleteObject();
+        _task = nullptr;
+    }
+    SAFE_DELETE_GPU_RESOURCE(_output);
+    SAFE_DELETE_GPU_RESOURCE(_headlessInput);
+    for (auto& e : _pendingQueries)
+        _freeQueries.Add(e.Query);
+    if (_activeQuery)
+        _freeQueries.Add(_activeQuery);
+    for (GPUTimerQuery* query : _freeQueries)
+        SAFE_DELETE_GPU_RESOURCE(query);
+}
+
+void DLSSBenchmark::Update()
+{
+    if (_done)
+        return;
+    if (!_started && !Start())
+        return;
+    ResolveQueries();
+
+    // Complete the last recorded frame
+    if (_currentSample != -1)
+    {
+        auto& sample = _samples[_currentSample];
+        sample.FrameTimeMs = (float)Time::Draw.UnscaledDeltaTime.GetTotalMilliseconds();
+        sample.GPUMemory = GPUDevice::Instance->GetMemoryUsage();
+        sample.ProcessMemory = Platform::GetProcessMemoryStats().UsedPhysicalMemory;
+        _currentSample = -1;
+    }
+
+    // Wait for the GPU timer queries to finish
+    if (_configIndex >= _configs.Count())
+    {
+        _task->Enabled = false;
+        _drawConfigIndex = -1;
+        if (_pendingQueries.IsEmpty() || ++_flushFrames > 30)
+        {
+            _failed = Save() || Validate();
+            _done = true;
+        }
+        return;
+    }
+
+    if (_frame == 0)
+        BeginConfig();
+    _drawConfigIndex = _configIndex;
+    if (_frame >= _settings.WarmupFrames)
+    {
+        _currentSample = _samples.Count();
+        auto& sample = _samples.AddOne();
+        Platform::MemoryClear(&sample, sizeof(sample));
+        sample.ConfigIndex = _configIndex;
+        sample.Frame = _frame - _settings.WarmupFrames;
+        sample.GpuTimeMs = -1.0f;
+    }
+    const int32 totalFrames = _settings.WarmupFrames + _settings.Frames;
+    UpdateCamera((float)_frame / (float)totalFrames);
+    if (_headlessInput)
+        DrawHeadless();
+    if (++_frame >= totalFrames)
+    {
+        _frame = 0;
+        _configIndex++;
+    }
+}
+
+void DLSSBenchmark::OnResolveBegin(GPUContext* context, const RenderContext& renderContext)
+{
+    if (renderContext.Task != _task || _currentSample == -1 || _activeQuery)
+        return;
+    if (_freeQueries.HasItems())
+        _activeQuery = _freeQueries.Pop();
+    else
+        _activeQuery = GPUDevice::Instance->CreateTimerQuery();
+    if (_activeQuery)
+        _activeQuery->Begin();
+}
+
+void DLSSBenchmark::OnResolveEnd(GPUContext* context, const RenderContext& renderContext, const NGXStats& stats)
+{
+    if (renderContext.Task != _task || _drawConfigIndex == -1)
+        return;
+    if (stats.CreateTimeMs > 0.0f)
+        _configs[_drawConfigIndex].FeatureCreateTimeMs = stats.CreateTimeMs;
+    if (_currentSample == -1)
+        return;
+    auto& sample = _samples[_currentSample];
+    sample.Resolved = true;
+    sample.CpuTimeMs = stats.EvaluateTimeMs;
+    sample.FeatureCreateTimeMs = stats.CreateTimeMs;
+    sample.FeatureMemory = stats.MemoryUsage;
+    if (_activeQuery)
+    {
+        _activeQuery->End();
+        _pendingQueries.Add({ _activeQuery, _currentSample });
+        _activeQuery = nullptr;
+    }
+}
+
+bool DLSSBenchmark::Start()
+{
+    // Wait for the scene camera (eg. when started during the game startup before the first scene gets loaded)
+    _camera = Camera::GetMainCamera();
+    if (!_camera && ++_waitFrames < 300)
+        return false;
+    if (!_camera)
+    {
+        LOG(Warning, "DLSS benchmark: no scene camera found, rendering with a default camera.");
+        _ownedCamera = New<Camera>(ScriptingObjectSpawnParams(Guid::New(), Camera::TypeInitializer));
+        _camera = _ownedCamera;
+    }
+    _cameraTransform = _camera->GetTransform();
+    _task->Camera = _camera;
+    _started = true;
+    return true;
+}
+
+void DLSSBenchmark::BeginConfig()
+{
+    const auto& config = _configs[_configIndex];
+    LOG(Info, "DLSS benchmark: {} at {}x{}", String(GetQualityName(config.Quality)), config.DisplaySize.X, config.DisplaySize.Y);
+
+    // Resize output
+    if (_output->Size() != config.DisplaySize)
+    {
+        _output->ReleaseGPU();
+        if (_output->Init(GPUTextureDescription::New2D(config.DisplaySize.X, config.DisplaySize.Y, PixelFormat::R8G8B8A8_UNorm)))
+            LOG(Error, "Failed to create DLSS benchmark output texture.");
+    }
+    if (_headlessInput && _headlessInput->Size() != config.Settings.ResolutionOptimal)
+    {
+        _headlessInput->ReleaseGPU();
+        if (_headlessInput->Init(GPUTextureDescription::New2D(config.Settings.ResolutionOptimal.X, config.Settings.ResolutionOptimal.Y, PixelFormat::R16G16B16A16_Float)))
+            LOG(Error, "Failed to create DLSS benchmark input texture.");
+    }
+
+    // Apply settings
+    _task->Camera = _camera;
+    _task->RenderingPercentage = Math::Min((float)config.Settings.ResolutionOptimal.X / (float)config.DisplaySize.X, (float)config.Settings.ResolutionOptimal.Y / (float)config.DisplaySize.Y);
+    _task->CameraCut();
+    _task->Enabled = true;
+    _dlss->Quality = config.Quality;
+    _dlss->Sharpness = config.Settings.Sharpness;
+}
+
+void DLSSBenchmark::DrawHeadless()
+{
+    // Scene rendering doesn't run without GPU, so upscale directly with the stand-in backend at the tested sizes (verifies the whole benchmark flow on GPU-less machines)
+    const auto& config = _configs[_drawConfigIndex];
+    GPUContext* context = GPUDevice::Instance->GetMainContext();
+    RenderContext renderContext;
+    renderContext.Task = _task;
+    OnResolveBegin(context, renderContext);
+    _dlss->_ngx.TemporalResolve(context, renderContext, _headlessInput, _output, nullptr, nullptr, config.Quality, DLSSMotionVectorsFlags::None, Float2::Zero, config.Settings.Sharpness);
+    OnResolveEnd(context, renderContext, _dlss->_ngx.GetStats());
+}
+
+void DLSSBenchmark::UpdateCamera(float time)
+{
+    if (!_camera)
+        return;
+
+    // Orbit around the initial camera location (the same path for every configuration)
+    const float angle = time * PI * 2.0f;
+    Transform transform = _cameraTransform;
+    transform.Translation += Vector3(Math::Sin(angle), 0.0f, Math::Cos(angle) - 1.0f) * _settings.CameraPathRadius;
+    transform.Orientation = Quaternion::Euler(0.0f, angle * RadiansToDegrees, 0.0f) * _cameraTransform.Orientation;
+    _camera->SetTransform(transform);
+}
+
+void DLSSBenchmark::ResolveQueries()
+{
+    for (int32 i = _pendingQueries.Count() - 1; i >= 0; i--)
+    {
+        auto& e = _pendingQueries[i];
+        if (!e.Query->HasResult())
+            continue;
+        _samples[e.SampleIndex].GpuTimeMs = e.Query->GetResult();
+        _freeQueries.Add(e.Query);
+        _pendingQueries.RemoveAtKeepOrder(i);
+    }
+}
+
+bool DLSSBenchmark::Save()
+{
+    // Per-frame results
+    StringBuilder csv;
+    csv.Append(TEXT("Quality,DisplayWidth,DisplayHeight,RenderWidth,RenderHeight,Frame,Resolved,FrameTimeMs,CpuTimeMs,GpuTimeMs,FeatureCreateTimeMs,FeatureMemoryMB,GPUMemoryMB,ProcessMemoryMB\n"));
+    for (const Sample& sample : _samples)
+    {
+        const Config& config = _configs[sample.ConfigIndex];
+        csv.AppendFormat(TEXT("{},{},{},{},{},{},{},{},{},{},{},{},{},{}\n"),
+                         String(GetQualityName(config.Quality)), config.DisplaySize.X, config.DisplaySize.Y, config.Settings.ResolutionOptimal.X, config.Settings.ResolutionOptimal.Y,
+                         sample.Frame, sample.Resolved ? 1 : 0, sample.FrameTimeMs, sample.CpuTimeMs, sample.GpuTimeMs, sample.FeatureCreateTimeMs,
+                         ToMB(sample.FeatureMemory), ToMB(sample.GPUMemory), ToMB(sample.ProcessMemory));
+    }
+    const String csvPath = _settings.OutputPath + TEXT(".csv");
+    if (File::WriteAllText(csvPath, csv, Encoding::ANSI))
+    {
+        LOG(Error, "Failed to save DLSS benchmark results to {}", csvPath);
+        return true;
+    }
+
+    // Summary per configuration
+    rapidjson_flax::StringBuffer buffer;
+    PrettyJsonWriter writer(buffer);
+    writer.StartObject();
+    writer.JKEY("Renderer");
+    writer.String(ToString(GPUDevice::Instance->GetRendererType()));
+    writer.JKEY("StandIn");
+    writer.Bool(_dlss->_ngx.IsStandIn());
+    writer.JKEY("WarmupFrames");
+    writer.Int(_settings.WarmupFrames);
+    writer.JKEY("Frames");
+    writer.Int(_settings.Frames);
+    writer.JKEY("Results");
+    writer.StartArray();
+    for (int32 configIndex = 0; configIndex < _configs.Count(); configIndex++)
+    {
+        const Config& config = _configs[configIndex];
+        int32 count = 0, resolvedCount = 0, gpuCount = 0;
+        float frameTime = 0.0f, cpuTime = 0.0f, gpuTime = 0.0f, frameTimeMax = 0.0f;
+        uint64 featureMemory = 0, gpuMemory = 0, processMemory = 0;
+        for (const Sample& sample : _samples)
+        {
+            if (sample.ConfigIndex != configIndex)
+                continue;
+            count++;
+            frameTime += sample.FrameTimeMs;
+            frameTimeMax = Math::Max(frameTimeMax, sample.FrameTimeMs);
+            gpuMemory = Math::Max(gpuMemory, sample.GPUMemory);
+            processMemory = Math::Max(processMemory, sample.ProcessMemory);
+            if (sample.Resolved)
+            {
+                resolvedCount++;
+                cpuTime += sample.CpuTimeMs;
+                featureMemory = Math::Max(featureMemory, sample.FeatureMemory);
+            }
+            if (sample.GpuTimeMs >= 0.0f)
+            {
+                gpuCount++;
+                gpuTime += sample.GpuTimeMs;
+            }
+        }
+        writer.StartObject();
+        writer.JKEY("Quality");
+        writer.String(GetQualityName(config.Quality));
+        writer.JKEY("DisplaySize");
+        WriteSize(writer, config.DisplaySize);
+        writer.JKEY("RenderSize");
+        WriteSize(writer, config.Settings.ResolutionOptimal);
+        writer.JKEY("Sharpness");
+        writer.Float(config.Settings.Sharpness);
+        writer.JKEY("Frames");
+        writer.Int(count);
+        writer.JKEY("ResolvedFrames");
+        writer.Int(resolvedCount);
+        writer.JKEY("FrameTimeMsAvg");
+        writer.Float(count ? frameTime / (float)count : 0.0f);
+        writer.JKEY("FrameTimeMsMax");
+        writer.Float(frameTimeMax);
+        writer.JKEY("CpuTimeMsAvg");
+        writer.Float(resolvedCount ? cpuTime / (float)resolvedCount : 0.0f);
+        writer.JKEY("GpuTimeMsAvg");
+        writer.Float(gpuCount ? gpuTime / (float)gpuCount : -1.0f);
+        writer.JKEY("FeatureCreateTimeMs");
+        writer.Float(config.FeatureCreateTimeMs);
+        writer.JKEY("FeatureMemoryMB");
+        writer.Float(ToMB(featureMemory));
+        writer.JKEY("GPUMemoryMB");
+        writer.Float(ToMB(gpuMemory));
+        writer.JKEY("ProcessMemoryMB");
+        writer.Float(ToMB(processMemory));
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.JKEY("Unsupported");
+    writer.StartArray();
+    for (const UnsupportedConfig& config : _unsupportedConfigs)
+    {
+        writer.StartObject();
+        writer.JKEY("Quality");
+        writer.String(GetQualityName(config.Quality));
+        writer.JKEY("DisplaySize");
+        WriteSize(writer, config.DisplaySize);
+        writer.EndObject();
+    }
+    writer.EndArray();
+    writer.EndObject();
+    const String jsonPath = _settings.OutputPath + TEXT(".json");
+    if (File::WriteAllBytes(jsonPath, buffer.GetString(), (int32)buffer.GetSize()))
+    {
+        LOG(Error, "Failed to save DLSS benchmark results to {}", jsonPath);
+        return true;
+    }
+
+    LOG(Info, "DLSS benchmark results saved to {}", _settings.OutputPath);
+    return false;
+}
+
+bool DLSSBenchmark::Validate() const
+{
+    // Every frame has to be recorded and upscaled (by DLSS or the stand-in backend)
+    if (_samples.Count() != _configs.Count() * _settings.Frames)
+    {
+        LOG(Error, "DLSS benchmark recorded {} frames, expected {}", _samples.Count(), _configs.Count() * _settings.Frames);
+        return true;
+    }
+    for (const Sample& sample : _samples)
+    {
+        if (!sample.Resolved)
+        {
+            LOG(Error, "DLSS benchmark frame {} of {} at {}x{} was not upscaled by DLSS", sample.Frame, String(GetQualityName(_configs[sample.ConfigIndex].Quality)), _configs[sample.ConfigIndex].DisplaySize.X, _configs[sample.ConfigIndex].DisplaySize.Y);
+            return true;
+        }
+    }
+
+    // Read back saved files
+    const String csvPath = _settings.OutputPath + TEXT(".csv");
+    String csv;
+    if (File::ReadAllText(csvPath, csv))
+    {
+        LOG(Error, "Failed to read DLSS benchmark results from {}", csvPath);
+        return true;
+    }
+    int32 csvLines = 0;
+    for (int32 i = 0; i < csv.Length(); i++)
+    {
+        if (csv[i] == '\n')
+            csvLines++;
+    }
+    if (csvLines != _samples.Count() + 1)
+    {
+        LOG(Error, "Invalid DLSS benchmark results in {} ({} lines, expected {})", csvPath, csvLines, _samples.Count() + 1);
+        return true;
+    }
+    const String jsonPath = _settings.OutputPath + TEXT(".json");
+    Array<byte> json;
+    if (File::ReadAllBytes(jsonPath, json))
+    {
+        LOG(Error, "Failed to read DLSS benchmark results from {}", jsonPath);
+        return true;
+    }
+    rapidjson_flax::Document document;
+    document.Parse((const char*)json.Get(), json.Count());
+    if (document.HasParseError() || !document.IsObject())
+    {
+        LOG(Error, "Invalid DLSS benchmark results in {}", jsonPath);
+        return true;
+    }
+    const auto results = document.FindMember("Results");
+    if (results == document.MemberEnd() || !results->value.IsArray() || (int32)results->value.Size() != _configs.Count())
+    {
+        LOG(Error, "Invalid DLSS benchmark results in {} (missing configurations)", jsonPath);
+        return true;
+    }
+    return false;
+}
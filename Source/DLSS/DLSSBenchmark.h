@@ -0,0 +1,146 @@
+﻿#pragma once
+
+#include "Types.h"
+#include "Engine/Core/Math/Transform.h"
+#include "Engine/Level/Actors/Camera.h"
+#include "Engine/Scripting/ScriptingObjectReference.h"
+
+class DLSS;
+class GPUContext;
+class GPUTexture;
+class GPUTimerQuery;
+class SceneRenderTask;
+struct NGXStats;
+struct RenderContext;
+
+/// <summary>
+/// DLSS benchmark. Sweeps all quality modes over a list of output resolutions (using a fixed camera path) and records per-frame timings and memory usage into CSV and JSON files.
+/// </summary>
+class DLSSBenchmark
+{
+private:
+    struct Config
+    {
+        DLSSQuality Quality;
+        Int2 DisplaySize;
+        DLSSRecommendedSettings Settings;
+        float FeatureCreateTimeMs;
+    };
+
+    struct Sample
+    {
+        int32 ConfigIndex;
+        int32 Frame;
+        bool Resolved;
+        float FrameTimeMs;
+        float CpuTimeMs;
+        float GpuTimeMs;
+        float FeatureCreateTimeMs;
+        uint64 FeatureMemory;
+        uint64 GPUMemory;
+        uint64 ProcessMemory;
+    };
+
+    struct PendingQuery
+    {
+        GPUTimerQuery* Query;
+        int32 SampleIndex;
+    };
+
+    struct UnsupportedConfig
+    {
+        DLSSQuality Quality;
+        Int2 DisplaySize;
+    };
+
+    DLSS* _dlss;
+    DLSSBenchmarkSettings _settings;
+    Array<Config> _configs;
+    Array<UnsupportedConfig> _unsupportedConfigs;
+    Array<Sample> _samples;
+    Array<PendingQuery> _pendingQueries;
+    Array<GPUTimerQuery*> _freeQueries;
+    GPUTimerQuery* _activeQuery = nullptr;
+    SceneRenderTask* _task = nullptr;
+    GPUTexture* _output = nullptr;
+    GPUTexture* _headlessInput = nullptr;
+    ScriptingObjectReference<Camera> _camera;
+    Camera* _ownedCamera = nullptr;
+    Transform _cameraTransform;
+    DLSSQuality _prevQuality;
+    float _prevSharpness;
+    float _prevUpdateFPS;
+    float _prevDrawFPS;
+    bool _prevUseVSync;
+    bool _prevMainTaskEnabled = false;
+    int32 _waitFrames = 0;
+    int32 _configIndex = 0;
+    int32 _drawConfigIndex = -1;
+    int32 _frame = 0;
+    int32 _currentSample = -1;
+    int32 _flushFrames = 0;
+    bool _started = false;
+    bool _done = false;
+    bool _failed = false;
+
+public:
+    DLSSBenchmark(DLSS* dlss, const DLSSBenchmarkSettings& settings);
+    ~DLSSBenchmark();
+
+public:
+    /// <summary>
+    /// Returns true if benchmark has ended (results are saved).
+    /// </summary>
+    bool IsDone() const
+    {
+        return _done;
+    }
+
+    /// <summary>
+    /// Returns true if benchmark failed to save or validate the results.
+    /// </summary>
+    bool HasFailed() const
+    {
+        return _failed;
+    }
+
+    /// <summary>
+    /// Gets the render task used by the benchmark.
+    /// </summary>
+    SceneRenderTask* GetTask() const
+    {
+        return _task;
+    }
+
+    /// <summary>
+    /// Gets the benchmark settings.
+    /// </summary>
+    const DLSSBenchmarkSettings& GetSettings() const
+    {
+        return _settings;
+    }
+
+    /// <summary>
+    /// Updates the benchmark state. Called once per engine update, before drawing the frame.
+    /// </summary>
+    void Update();
+
+    /// <summary>
+    /// Called by the DLSS effect before running upscaling.
+    /// </summary>
+    void OnResolveBegin(GPUContext* context, const RenderContext& renderContext);
+
+    /// <summary>
+    /// Called by the DLSS effect after running upscaling.
+    /// </summary>
+    void OnResolveEnd(GPUContext* context, const RenderContext& renderContext, const NGXStats& stats);
+
+private:
+    bool Start();
+    void BeginConfig();
+    void DrawHeadless();
+    void UpdateCamera(float time);
+    void ResolveQueries();
+    bool Save();
+    bool Validate() const;
+};
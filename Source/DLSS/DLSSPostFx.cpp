@@ -1,12 +1,29 @@
 ﻿#include "DLSSPostFx.h"
 #include "DLSS.h"
+#include "DLSSBenchmark.h"
+#include "DLSSReactiveMask.h"
+#include "Engine/Core/Log.h"
 #include "Engine/Profiler/Profiler.h"
 #include "Engine/Scripting/Plugins/PluginManager.h"
 #include "Engine/Graphics/GPUContext.h"
+#include "Engine/Graphics/RenderBuffers.h"
 #include "Engine/Graphics/RenderTargetPool.h"
 #include "Engine/Graphics/Textures/GPUTexture.h"
 #include "Engine/Renderer/RenderList.h"
 
+namespace
+{
+    // Gets the custom motion vectors if their size matches the description (render or display resolution), otherwise null
+    GPUTexture* GetCustomMotionVectors(const DLSS* dlss, const Int2& renderSize, const Int2& displaySize)
+    {
+        GPUTexture* motionVectors = dlss->MotionVectors;
+        if (!motionVectors)
+            return nullptr;
+        const Int2 expectedSize = EnumHasAnyFlags(dlss->MotionVectorsFlags, DLSSMotionVectorsFlags::DisplayResolution) ? displaySize : renderSize;
+        return motionVectors->Size() == expectedSize ? motionVectors : nullptr;
+    }
+}
+
 DLSSPostFx::DLSSPostFx(const SpawnParams& params)
     : PostProcessEffect(params)
 {
@@ -18,8 +35,9 @@ bool DLSSPostFx::CanRender(const RenderContext& renderContext) const
     if (renderContext.Task->RenderingPercentage >= 1.0f)
         return false;
 
+    // Skip tasks excluded by the policy (eg. thumbnails, probes, tiny views) before DLSS gets initialized for them
     auto dlss = PluginManager::GetPlugin<DLSS>();
-    return PostProcessEffect::CanRender() && dlss && dlss->GetSupport() == DLSSSupport::Supported;
+    return PostProcessEffect::CanRender() && dlss && dlss->IsRenderTaskEnabled(renderContext.Task) && dlss->GetSupport() == DLSSSupport::Supported;
 }
 
 void DLSSPostFx::PreRender(GPUContext* context, RenderContext& renderContext)
@@ -33,6 +51,13 @@ void DLSSPostFx::PreRender(GPUContext* context, RenderContext& renderContext)
     // Enable temporal jitter
     renderContext.List->Setup.UseTemporalAAJitter = true;
 
+    // Request motion vectors pass unless using custom motion vectors
+    auto dlss = PluginManager::GetPlugin<DLSS>();
+    const Int2 renderSize((int32)renderContext.View.ScreenSize.X, (int32)renderContext.View.ScreenSize.Y);
+    const Int2 displaySize(renderContext.Task->GetOutputViewport().Size);
+    if (!GetCustomMotionVectors(dlss, renderSize, displaySize))
+        renderContext.List->Setup.UseMotionVectors = true;
+
     // Disable anti-aliasing
     renderContext.List->Settings.AntiAliasing.Mode = AntialiasingMode::None;
 }
@@ -52,11 +77,38 @@ void DLSSPostFx::Render(GPUContext* context, RenderContext& renderContext, GPUTe
         dlssOutput = RenderTargetPool::Get(desc);
     }
 
-    // Run DLSS
+    // Generate reactive mask for transparent geometry
     auto dlss = PluginManager::GetPlugin<DLSS>();
+    GPUTexture* reactiveMask = nullptr;
+    if (dlss->ReactiveMask && dlss->ReactiveMaskPostFx)
+        reactiveMask = dlss->ReactiveMaskPostFx->Generate(context, renderContext, input, Math::Max(dlss->ReactiveMaskScale, 0.0f), Math::Saturate(dlss->ReactiveMaskThreshold));
+
+    // Pick motion vectors (fallback to the engine motion vectors at render resolution if custom ones don't match the description)
+    GPUTexture* motionVectors = GetCustomMotionVectors(dlss, input->Size(), output->Size());
+    DLSSMotionVectorsFlags motionVectorsFlags = dlss->MotionVectorsFlags;
+    if (!motionVectors)
+    {
+        // Warn once per texture (other tasks, eg. secondary cameras, fall back to the engine motion vectors every frame)
+        if (dlss->MotionVectors && dlss->MotionVectors != _motionVectorsWarned)
+        {
+            const Int2 expectedSize = EnumHasAnyFlags(motionVectorsFlags, DLSSMotionVectorsFlags::DisplayResolution) ? output->Size() : input->Size();
+            LOG(Warning, "DLSS motion vectors size {}x{} doesn't match the expected {}x{} (check MotionVectorsFlags). Using engine motion vectors.", dlss->MotionVectors->Width(), dlss->MotionVectors->Height(), expectedSize.X, expectedSize.Y);
+            _motionVectorsWarned = dlss->MotionVectors;
+        }
+        motionVectors = renderContext.Task->Buffers->MotionVectors;
+        motionVectorsFlags &= ~(DLSSMotionVectorsFlags::DisplayResolution | DLSSMotionVectorsFlags::Jittered);
+    }
+
+    // Run DLSS
     const float sharpness = Math::Clamp(dlss->Sharpness, -1.0f, 1.0f);
-    const Float2 pixelOffset(renderContext.View.TemporalAAJitter.X * renderContext.View.ScreenSize.X / 2.0f, renderContext.View.TemporalAAJitter.X * renderContext.View.ScreenSize.Y / 2.0f);
-    dlss->_ngx.TemporalResolve(context, renderContext, input, dlssOutput, dlss->Quality, pixelOffset, sharpness);
+    const Float2 pixelOffset(renderContext.View.TemporalAAJitter.X * renderContext.View.ScreenSize.X / 2.0f, renderContext.View.TemporalAAJitter.Y * renderContext.View.ScreenSize.Y / 2.0f);
+    if (dlss->_benchmark)
+        dlss->_benchmark->OnResolveBegin(context, renderContext);
+    dlss->_ngx.TemporalResolve(context, renderContext, input, dlssOutput, motionVectors, reactiveMask, dlss->Quality, motionVectorsFlags, pixelOffset, sharpness);
+    if (dlss->_benchmark)
+        dlss->_benchmark->OnResolveEnd(context, renderContext, dlss->_ngx.GetStats());
+    if (reactiveMask)
+        RenderTargetPool::Release(reactiveMask);
 
     // Copy back results
     if (dlssOutput != output)
@@ -8,6 +8,9 @@
 API_CLASS(Namespace="NVIDIA") class DLSS_API DLSSPostFx : public PostProcessEffect
 {
     DECLARE_SCRIPTING_TYPE(DLSSPostFx);
+private:
+    const GPUTexture* _motionVectorsWarned = nullptr;
+
 public:
     // [PostProcessEffect]
     bool CanRender(const RenderContext& renderContext) const override;
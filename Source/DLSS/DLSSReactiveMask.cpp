@@ -0,0 +1,203 @@
+﻿#include "DLSSReactiveMask.h"
+#include "DLSS.h"
+#include "DLSSPostFx.h"
+#include "DLSSSettings.h"
+#include "Engine/Core/Log.h"
+#include "Engine/Content/Content.h"
+#include "Engine/Platform/Platform.h"
+#include "Engine/Profiler/Profiler.h"
+#include "Engine/Scripting/Plugins/PluginManager.h"
+#include "Engine/Graphics/GPUDevice.h"
+#include "Engine/Graphics/GPUContext.h"
+#include "Engine/Graphics/GPUPipelineState.h"
+#include "Engine/Graphics/RenderTargetPool.h"
+#include "Engine/Graphics/Shaders/GPUShader.h"
+#include "Engine/Graphics/Textures/GPUTexture.h"
+
+// Fallback location of the shader compiled from Source/Shaders/DLSS.shader (path relative to the game project folder), used if not assigned in DLSSSettings
+#define DLSS_SHADER_PATH TEXT("Plugins/DLSS/Content/Shaders/DLSS.flax")
+
+// Interval (in seconds) between attempts to find the missing shader (eg. imported while the editor is running)
+#define DLSS_SHADER_RETRY_INTERVAL 5.0
+
+PACK_STRUCT(struct ReactiveMaskData {
+    float ReactiveScale;
+    float ReactiveThreshold;
+    Float2 Dummy0;
+    });
+
+DLSSReactiveMaskPostFx::DLSSReactiveMaskPostFx(const SpawnParams& params)
+    : PostProcessEffect(params)
+{
+    Location = PostProcessEffectLocation::BeforeForwardPass;
+    UseSingleTarget = true;
+}
+
+DLSSReactiveMaskPostFx::~DLSSReactiveMaskPostFx()
+{
+    Dispose();
+}
+
+GPUTexture* DLSSReactiveMaskPostFx::Generate(GPUContext* context, RenderContext& renderContext, GPUTexture* input, float scale, float threshold)
+{
+    // Opaque color has to come from the same task and resolution
+    if (!_opaqueColor || _opaqueColorTask != renderContext.Task || _opaqueColor->Size() != input->Size())
+    {
+        ReleaseOpaqueColor();
+        return nullptr;
+    }
+    if (!_shader || !_shader->IsLoaded())
+    {
+        ReleaseOpaqueColor();
+        return nullptr;
+    }
+    PROFILE_GPU_CPU("Reactive Mask");
+    GPUShader* shader = _shader->GetShader();
+    if (!_psReactiveMask)
+        _psReactiveMask = GPUDevice::Instance->CreatePipelineState();
+    if (!_psReactiveMask->IsValid())
+    {
+        GPUPipelineState::Description psDesc = GPUPipelineState::Description::DefaultFullscreenTriangle;
+        psDesc.PS = shader->GetPS("PS_ReactiveMask");
+        if (_psReactiveMask->Init(psDesc))
+        {
+            LOG(Error, "Failed to create DLSS reactive mask pipeline state.");
+            ReleaseOpaqueColor();
+            return nullptr;
+        }
+    }
+
+    // Compare opaque-only color with the final color to find pixels affected by forward-rendered geometry
+    GPUTexture* mask = RenderTargetPool::Get(GPUTextureDescription::New2D(input->Width(), input->Height(), PixelFormat::R8_UNorm));
+    ReactiveMaskData data;
+    data.ReactiveScale = scale;
+    data.ReactiveThreshold = threshold;
+    data.Dummy0 = Float2::Zero;
+    GPUConstantBuffer* cb = shader->GetCB(0);
+    context->UpdateCB(cb, &data);
+    context->BindCB(0, cb);
+    context->BindSR(0, _opaqueColor);
+    context->BindSR(1, input);
+    context->SetViewportAndScissors((float)input->Width(), (float)input->Height());
+    context->SetRenderTarget(mask->View());
+    context->SetState(_psReactiveMask);
+    context->DrawFullscreenTriangle();
+    CustomDraw(context, renderContext, mask);
+    context->ResetRenderTarget();
+    context->ResetSR();
+    context->ResetCB();
+
+    ReleaseOpaqueColor();
+    return mask;
+}
+
+void DLSSReactiveMaskPostFx::Dispose()
+{
+    ReleaseOpaqueColor();
+    ReleaseShader();
+    SAFE_DELETE_GPU_RESOURCE(_psReactiveMask);
+    _shaderMissing = false;
+    _shaderMissingId = Guid::Empty;
+    _shaderRetryTime = 0.0;
+}
+
+bool DLSSReactiveMaskPostFx::LoadShader()
+{
+    const auto settings = DLSSSettings::Get();
+    const Guid settingsShaderId = settings->ReactiveMaskShader.GetID();
+    if (_shader && settingsShaderId.IsValid() && _shader->GetID() != settingsShaderId)
+        ReleaseShader();
+    if (_shaderMissing)
+    {
+        // Try again when the settings change or after a while (eg. shader imported while the editor is running)
+        if (settingsShaderId == _shaderMissingId && Platform::GetTimeSeconds() < _shaderRetryTime)
+            return true;
+    }
+    if (!_shader)
+    {
+        AssetInfo info;
+        if (settings->ReactiveMaskShader)
+            _shader = settings->ReactiveMaskShader.Get();
+        else if (Content::GetAssetInfo(DLSS_SHADER_PATH, info))
+            _shader = Content::LoadAsync<Shader>(info.ID);
+        if (!_shader)
+        {
+            if (!_shaderMissing || settingsShaderId != _shaderMissingId)
+                LOG(Warning, "Missing DLSS reactive mask shader. Assign it in DLSS settings (ReactiveMaskShader) or import Source/Shaders/DLSS.shader to {}. Reactive mask is disabled.", String(DLSS_SHADER_PATH));
+            _shaderMissing = true;
+            _shaderMissingId = settingsShaderId;
+            _shaderRetryTime = Platform::GetTimeSeconds() + DLSS_SHADER_RETRY_INTERVAL;
+            return true;
+        }
+#if COMPILE_WITH_DEV_ENV
+        _shader.Get()->OnReloading.Bind<DLSSReactiveMaskPostFx, &DLSSReactiveMaskPostFx::OnShaderReloading>(this);
+#endif
+    }
+    if (_shader->LastLoadFailed())
+    {
+        if (!_shaderMissing || settingsShaderId != _shaderMissingId)
+            LOG(Warning, "Failed to load DLSS reactive mask shader {}. Reactive mask is disabled.", _shader->GetPath());
+        ReleaseShader();
+        _shaderMissing = true;
+        _shaderMissingId = settingsShaderId;
+        _shaderRetryTime = Platform::GetTimeSeconds() + DLSS_SHADER_RETRY_INTERVAL;
+        return true;
+    }
+    _shaderMissing = false;
+    return !_shader->IsLoaded();
+}
+
+void DLSSReactiveMaskPostFx::ReleaseShader()
+{
+    if (_shader)
+    {
+#if COMPILE_WITH_DEV_ENV
+        _shader.Get()->OnReloading.Unbind<DLSSReactiveMaskPostFx, &DLSSReactiveMaskPostFx::OnShaderReloading>(this);
+#endif
+        _shader = nullptr;
+    }
+    if (_psReactiveMask)
+        _psReactiveMask->ReleaseGPU();
+}
+
+void DLSSReactiveMaskPostFx::ReleaseOpaqueColor()
+{
+    if (_opaqueColor)
+    {
+        RenderTargetPool::Release(_opaqueColor);
+        _opaqueColor = nullptr;
+    }
+    _opaqueColorTask = nullptr;
+}
+
+#if COMPILE_WITH_DEV_ENV
+
+void DLSSReactiveMaskPostFx::OnShaderReloading(Asset* obj)
+{
+    if (_psReactiveMask)
+        _psReactiveMask->ReleaseGPU();
+}
+
+#endif
+
+bool DLSSReactiveMaskPostFx::CanRender(const RenderContext& renderContext) const
+{
+    auto dlss = PluginManager::GetPlugin<DLSS>();
+    if (!dlss || !dlss->ReactiveMask || !dlss->PostFx || !dlss->PostFx->CanRender(renderContext))
+        return false;
+
+    // Lazy-load shader
+    return PostProcessEffect::CanRender() && !const_cast<DLSSReactiveMaskPostFx*>(this)->LoadShader();
+}
+
+void DLSSReactiveMaskPostFx::Render(GPUContext* context, RenderContext& renderContext, GPUTexture* input, GPUTexture* output)
+{
+    PROFILE_GPU_CPU("DLSS Opaque Color");
+
+    // Capture scene color before transparent geometry gets rendered
+    ReleaseOpaqueColor();
+    GPUTextureDescription desc = GPUTextureDescription::New2D(input->Width(), input->Height(), input->Format());
+    _opaqueColor = RenderTargetPool::Get(desc);
+    _opaqueColorTask = renderContext.Task;
+    context->CopyResource(_opaqueColor, input);
+}
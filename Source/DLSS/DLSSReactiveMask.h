@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include "Engine/Graphics/PostProcessEffect.h"
+#include "Engine/Content/AssetReference.h"
+#include "Engine/Content/Assets/Shader.h"
+
+class GPUPipelineState;
+
+/// <summary>
+/// DLSS reactive mask generator. Captures the scene color before the forward pass (opaque-only) and compares it against the upscaler input to find pixels covered by transparent geometry (eg. particles, emissive VFX, alpha-blended materials).
+/// </summary>
+API_CLASS(Namespace="NVIDIA") class DLSS_API DLSSReactiveMaskPostFx : public PostProcessEffect
+{
+    DECLARE_SCRIPTING_TYPE(DLSSReactiveMaskPostFx);
+private:
+    AssetReference<Shader> _shader;
+    GPUPipelineState* _psReactiveMask = nullptr;
+    GPUTexture* _opaqueColor = nullptr;
+    const RenderTask* _opaqueColorTask = nullptr;
+    bool _shaderMissing = false;
+    Guid _shaderMissingId;
+    double _shaderRetryTime = 0.0;
+
+public:
+    ~DLSSReactiveMaskPostFx();
+
+    /// <summary>
+    /// Custom reactive mask drawing event. Called after generating the automatic mask with the mask texture bound as render target (render resolution, single channel). Can be used to draw geometry with materials that should be treated as reactive.
+    /// </summary>
+    Delegate<GPUContext*, RenderContext&, GPUTexture*> CustomDraw;
+
+    /// <summary>
+    /// Generates the reactive mask for the current frame. Returns null if the mask is not available (eg. opaque color was not captured for this task). Release result with RenderTargetPool.
+    /// </summary>
+    /// <param name="context">The GPU context.</param>
+    /// <param name="renderContext">The rendering context.</param>
+    /// <param name="input">The scene color (render resolution) to be upscaled.</param>
+    /// <param name="scale">The reactive mask values scale.</param>
+    /// <param name="threshold">The minimum color difference to mark pixel as reactive.</param>
+    /// <returns>The mask texture or null.</returns>
+    GPUTexture* Generate(GPUContext* context, RenderContext& renderContext, GPUTexture* input, float scale, float threshold);
+
+    /// <summary>
+    /// Releases the cached resources.
+    /// </summary>
+    void Dispose();
+
+private:
+    bool LoadShader();
+    void ReleaseShader();
+    void ReleaseOpaqueColor();
+#if COMPILE_WITH_DEV_ENV
+    void OnShaderReloading(Asset* obj);
+#endif
+
+public:
+    // [PostProcessEffect]
+    bool CanRender(const RenderContext& renderContext) const override;
+    void Render(GPUContext* context, RenderContext& renderContext, GPUTexture* input, GPUTexture* output) override;
+};
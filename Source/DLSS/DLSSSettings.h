@@ -2,6 +2,8 @@
 
 #include "Engine/Core/Config/Settings.h"
 #include "Engine/Scripting/ScriptingObject.h"
+#include "Engine/Content/AssetReference.h"
+#include "Engine/Content/Assets/Shader.h"
 
 /// <summary>
 /// The settings for NVIDIA DLSS plugin.
@@ -24,4 +26,8 @@ public:
     // If checked, DLSS initialization will be delayed until actually used.
     API_FIELD(Attributes="EditorOrder(100)")
     bool LazyInit = true;
+
+    // Shader used to generate the reactive mask (compiled from Source/Shaders/DLSS.shader). If not set, the shader is loaded from Plugins/DLSS/Content/Shaders/DLSS.flax within the game project.
+    API_FIELD(Attributes="EditorOrder(200)")
+    AssetReference<Shader> ReactiveMaskShader;
 };
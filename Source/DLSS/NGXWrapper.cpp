@@ -1,6 +1,7 @@
 ﻿#include "NGXWrapper.h"
 #include "Engine/Core/Log.h"
 #include "Engine/Engine/Time.h"
+#include "Engine/Engine/Engine.h"
 #include "Engine/Engine/Globals.h"
 #include "Engine/Platform/FileSystem.h"
 #include "Engine/Graphics/GPUDevice.h"
@@ -42,6 +43,161 @@ void GetVulkanResource(NVSDK_NGX_Resource_VK& resource, GPUTexture* texture, NVS
 
 #endif
 
+// Per-frame DLSS evaluation inputs (shared by all backends)
+struct NGXEvalInputs
+{
+    GPUTexture* Output;
+    GPUTexture* Color;
+    GPUTexture* Depth;
+    GPUTexture* MotionVectors;
+    GPUTexture* ReactiveMask;
+    Int2 RenderSize;
+    Float2 MotionVectorsScale;
+    Float2 Jitter;
+    float Sharpness;
+    float FrameTimeDeltaMs;
+    bool Reset;
+};
+
+// Native resource passed to the evaluation params (D3D backends pass resources directly)
+template<typename ResourceType>
+struct NGXResourceSlotD3D
+{
+    ResourceType* Get(GPUTexture* texture)
+    {
+        return texture ? (ResourceType*)texture->GetNativePtr() : nullptr;
+    }
+};
+
+struct NGXBackendD3D11
+{
+    typedef NVSDK_NGX_D3D11_DLSS_Eval_Params EvalParams;
+    typedef NGXResourceSlotD3D<ID3D11Resource> ResourceSlot;
+
+    static NVSDK_NGX_Result AllocateParameters(NVSDK_NGX_Parameter** parameters)
+    {
+        return NVSDK_NGX_D3D11_AllocateParameters(parameters);
+    }
+
+    static NVSDK_NGX_Result CreateFeature(void* contextNative, NVSDK_NGX_Handle** handle, NVSDK_NGX_Parameter* parameters, NVSDK_NGX_DLSS_Create_Params* createParams)
+    {
+        return NGX_D3D11_CREATE_DLSS_EXT((ID3D11DeviceContext*)contextNative, handle, parameters, createParams);
+    }
+
+    static NVSDK_NGX_Result ReleaseFeature(NVSDK_NGX_Handle* handle)
+    {
+        return NVSDK_NGX_D3D11_ReleaseFeature(handle);
+    }
+
+    static void PreEvaluate(GPUContext* context, const NGXEvalInputs& inputs)
+    {
+    }
+
+    static NVSDK_NGX_Result Evaluate(void* contextNative, NVSDK_NGX_Handle* handle, NVSDK_NGX_Parameter* parameters, EvalParams* evalParams)
+    {
+        return NGX_D3D11_EVALUATE_DLSS_EXT((ID3D11DeviceContext*)contextNative, handle, parameters, evalParams);
+    }
+
+    static void PostEvaluate(GPUContext* context)
+    {
+    }
+};
+
+struct NGXBackendD3D12
+{
+    typedef NVSDK_NGX_D3D12_DLSS_Eval_Params EvalParams;
+    typedef NGXResourceSlotD3D<ID3D12Resource> ResourceSlot;
+
+    static NVSDK_NGX_Result AllocateParameters(NVSDK_NGX_Parameter** parameters)
+    {
+        return NVSDK_NGX_D3D12_AllocateParameters(parameters);
+    }
+
+    static NVSDK_NGX_Result CreateFeature(void* contextNative, NVSDK_NGX_Handle** handle, NVSDK_NGX_Parameter* parameters, NVSDK_NGX_DLSS_Create_Params* createParams)
+    {
+        return NGX_D3D12_CREATE_DLSS_EXT((ID3D12GraphicsCommandList*)contextNative, 1, 1, handle, parameters, createParams);
+    }
+
+    static NVSDK_NGX_Result ReleaseFeature(NVSDK_NGX_Handle* handle)
+    {
+        return NVSDK_NGX_D3D12_ReleaseFeature(handle);
+    }
+
+    static void PreEvaluate(GPUContext* context, const NGXEvalInputs& inputs)
+    {
+        // Put resources into proper state
+        context->SetResourceState(inputs.Output, 0x8); // D3D12_RESOURCE_STATE_UNORDERED_ACCESS
+        context->SetResourceState(inputs.Color, 0x40 | 0x80); // D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+        context->SetResourceState(inputs.Depth, 0x40 | 0x80); // D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+        if (inputs.MotionVectors)
+            context->SetResourceState(inputs.MotionVectors, 0x40 | 0x80); // D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+        if (inputs.ReactiveMask)
+            context->SetResourceState(inputs.ReactiveMask, 0x40 | 0x80); // D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
+    }
+
+    static NVSDK_NGX_Result Evaluate(void* contextNative, NVSDK_NGX_Handle* handle, NVSDK_NGX_Parameter* parameters, EvalParams* evalParams)
+    {
+        return NGX_D3D12_EVALUATE_DLSS_EXT((ID3D12GraphicsCommandList*)contextNative, handle, parameters, evalParams);
+    }
+
+    static void PostEvaluate(GPUContext* context)
+    {
+        // Ensure that root signature and descriptor heaps are properly set after DLSS modified them
+        context->ForceRebindDescriptors();
+    }
+};
+
+#if GRAPHICS_API_VULKAN
+
+// Vulkan resource passed to the evaluation params (NGX references resource descriptor stored in the slot)
+struct NGXResourceSlotVulkan
+{
+    NVSDK_NGX_Resource_VK Resource;
+
+    NVSDK_NGX_Resource_VK* Get(GPUTexture* texture)
+    {
+        NVSDK_NGX_Resource_VK* ptr;
+        GetVulkanResource(Resource, texture, ptr);
+        return ptr;
+    }
+};
+
+struct NGXBackendVulkan
+{
+    typedef NVSDK_NGX_VK_DLSS_Eval_Params EvalParams;
+    typedef NGXResourceSlotVulkan ResourceSlot;
+
+    static NVSDK_NGX_Result AllocateParameters(NVSDK_NGX_Parameter** parameters)
+    {
+        return NVSDK_NGX_VULKAN_AllocateParameters(parameters);
+    }
+
+    static NVSDK_NGX_Result CreateFeature(void* contextNative, NVSDK_NGX_Handle** handle, NVSDK_NGX_Parameter* parameters, NVSDK_NGX_DLSS_Create_Params* createParams)
+    {
+        return NGX_VULKAN_CREATE_DLSS_EXT((VkCommandBuffer)contextNative, 1, 1, handle, parameters, createParams);
+    }
+
+    static NVSDK_NGX_Result ReleaseFeature(NVSDK_NGX_Handle* handle)
+    {
+        return NVSDK_NGX_VULKAN_ReleaseFeature(handle);
+    }
+
+    static void PreEvaluate(GPUContext* context, const NGXEvalInputs& inputs)
+    {
+    }
+
+    static NVSDK_NGX_Result Evaluate(void* contextNative, NVSDK_NGX_Handle* handle, NVSDK_NGX_Parameter* parameters, EvalParams* evalParams)
+    {
+        return NGX_VULKAN_EVALUATE_DLSS_EXT((VkCommandBuffer)contextNative, handle, parameters, evalParams);
+    }
+
+    static void PostEvaluate(GPUContext* context)
+    {
+    }
+};
+
+#endif
+
 NVSDK_NGX_PerfQuality_Value GetQuality(DLSSQuality quality)
 {
     switch (quality)
@@ -60,6 +216,25 @@ NVSDK_NGX_PerfQuality_Value GetQuality(DLSSQuality quality)
     }
 }
 
+Float2 GetStandInScale(DLSSQuality quality)
+{
+    // Per-axis scale factors matching NGX optimal settings
+    switch (quality)
+    {
+    case DLSSQuality::UltraPerformance:
+        return Float2(0.333f);
+    case DLSSQuality::Performance:
+        return Float2(0.5f);
+    case DLSSQuality::Balanced:
+        return Float2(0.58f);
+    case DLSSQuality::Quality:
+        return Float2(0.667f);
+    case DLSSQuality::UltraQuality:
+    default:
+        return Float2(0.77f);
+    }
+}
+
 bool NGXWrapper::Initialize(uint32 appId, const StringAnsi& projectId, DLSSSupport& support)
 {
     // Check DLSS support
@@ -163,11 +338,28 @@ bool NGXWrapper::Initialize(uint32 appId, const StringAnsi& projectId, DLSSSuppo
     return false;
 }
 
+bool NGXWrapper::InitializeStandIn(DLSSSupport& support)
+{
+    // Stand-in backend mimics NGX behavior without calling into it (used by benchmark on machines without DLSS support)
+    LOG(Info, "Using DLSS stand-in backend");
+    _rendererType = GPUDevice::Instance->GetRendererType();
+    _standIn = true;
+    support = DLSSSupport::Supported;
+    _initialized = true;
+    return false;
+}
+
 void NGXWrapper::Shutdown()
 {
     if (!_initialized)
         return;
     _initialized = false;
+    _stats = NGXStats();
+    if (_standIn)
+    {
+        _standIn = false;
+        return;
+    }
 
     _capabilityParameters = nullptr;
     NVSDK_NGX_Result result = NVSDK_NGX_Result_Fail;
@@ -176,17 +368,20 @@ void NGXWrapper::Shutdown()
     switch (_rendererType)
     {
     case RendererType::DirectX11:
+        ReleaseFeatures<NGXBackendD3D11>(true);
         if (_parametersObject)
             NVSDK_NGX_D3D11_DestroyParameters(_parametersObject);
         result = NVSDK_NGX_D3D11_Shutdown1((ID3D11Device*)gpuDeviceNative);
         break;
     case RendererType::DirectX12:
+        ReleaseFeatures<NGXBackendD3D12>(true);
         if (_parametersObject)
             NVSDK_NGX_D3D12_DestroyParameters(_parametersObject);
         result = NVSDK_NGX_D3D12_Shutdown1((ID3D12Device*)gpuDeviceNative);
         break;
 #if GRAPHICS_API_VULKAN
     case RendererType::Vulkan:
+        ReleaseFeatures<NGXBackendVulkan>(true);
         if (_parametersObject)
             NVSDK_NGX_VULKAN_DestroyParameters(_parametersObject);
         result = NVSDK_NGX_VULKAN_Shutdown1((VkDevice)((void**)gpuDeviceNative)[1]);
@@ -194,8 +389,6 @@ void NGXWrapper::Shutdown()
 #endif
     }
     _parametersObject = nullptr;
-    _paramsHandle = nullptr;
-    _params = NGXParams();
     if (NVSDK_NGX_FAILED(result))
     {
         LOG(Error, "Failed to shutdown NGX. Error code: 0x{:x}, {}", (uint32)result, GetNGXResultAsString(result));
@@ -204,6 +397,15 @@ void NGXWrapper::Shutdown()
 
 void NGXWrapper::QueryRecommendedSettings(const Int2& displaySize, DLSSRecommendedSettings& output, DLSSQuality quality) const
 {
+    if (_initialized && _standIn)
+    {
+        const Float2 scale = GetStandInScale(quality);
+        output.ResolutionOptimal = Int2((int32)((float)displaySize.X * scale.X), (int32)((float)displaySize.Y * scale.Y));
+        output.ResolutionMin = output.ResolutionOptimal;
+        output.ResolutionMax = displaySize;
+        output.Sharpness = 0.0f;
+        return;
+    }
     if (_initialized)
     {
         NVSDK_NGX_PerfQuality_Value dlssQuality = GetQuality(quality);
@@ -226,159 +428,176 @@ void NGXWrapper::QueryRecommendedSettings(const Int2& displaySize, DLSSRecommend
     output.Sharpness = 0.0f;
 }
 
-void NGXWrapper::TemporalResolve(GPUContext* context, RenderContext& renderContext, GPUTexture* input, GPUTexture* output, DLSSQuality quality, const Float2& pixelOffset, float sharpness)
+void NGXWrapper::TemporalResolve(GPUContext* context, RenderContext& renderContext, GPUTexture* input, GPUTexture* output, GPUTexture* motionVectors, GPUTexture* reactiveMask, DLSSQuality quality, DLSSMotionVectorsFlags motionVectorsFlags, const Float2& pixelOffset, float sharpness)
 {
     ASSERT(_initialized);
-    NVSDK_NGX_Result result = NVSDK_NGX_Result_Fail;
-    void* contextNative = context->GetNativePtr();
+    _stats.CreateTimeMs = 0.0f;
 
     // Build params for current pass
     NGXParams params;
     params.SrcSize = input->Size();
     params.DstSize = output->Size();
     params.Quality = quality;
+    params.MotionVectorsFlags = motionVectorsFlags;
     params.UseSharpness = !Math::IsZero(sharpness);
-    if (params != _params)
+    if (_standIn)
     {
-        _params = params;
+        // Simple stretch-copy instead of the DLSS feature
+        const double startTime = Platform::GetTimeSeconds();
+        context->SetViewportAndScissors((float)params.DstSize.X, (float)params.DstSize.Y);
+        context->SetRenderTarget(output->View());
+        context->Draw(input);
+        context->ResetRenderTarget();
+        context->ResetSR();
+        _stats.EvaluateTimeMs = (float)((Platform::GetTimeSeconds() - startTime) * 1000.0);
+        return;
+    }
+
+    // Evaluate DLSS (each render task uses own feature so tasks with different sizes or motion vectors don't recreate it every frame)
+    Feature& feature = _features[renderContext.Task];
+    feature.LastUsedFrame = Engine::FrameCount;
+    NGXEvalInputs inputs;
+    inputs.Output = output;
+    inputs.Color = input;
+    inputs.Depth = renderContext.Task->Buffers->DepthBuffer;
+    inputs.MotionVectors = motionVectors;
+    inputs.ReactiveMask = reactiveMask;
+    inputs.RenderSize = params.SrcSize;
+    inputs.MotionVectorsScale = motionVectors ? Float2(motionVectors->Size()) : Float2(params.SrcSize); // scale motion vectors from normalized [-1;1] to pixel-space
+    inputs.Jitter = pixelOffset;
+    inputs.Sharpness = sharpness;
+    inputs.FrameTimeDeltaMs = (float)Time::Draw.UnscaledDeltaTime.GetTotalMilliseconds();
+    inputs.Reset = renderContext.Task->IsCameraCut;
+    switch (_rendererType)
+    {
+    case RendererType::DirectX11:
+        Evaluate<NGXBackendD3D11>(context, feature, params, inputs);
+        break;
+    case RendererType::DirectX12:
+        Evaluate<NGXBackendD3D12>(context, feature, params, inputs);
+        break;
+#if GRAPHICS_API_VULKAN
+    case RendererType::Vulkan:
+        Evaluate<NGXBackendVulkan>(context, feature, params, inputs);
+        break;
+#endif
+    }
+}
+
+template<typename Backend>
+void NGXWrapper::Evaluate(GPUContext* context, Feature& feature, const NGXParams& params, const NGXEvalInputs& inputs)
+{
+    ReleaseFeatures<Backend>(false);
+    NVSDK_NGX_Result result = NVSDK_NGX_Result_Fail;
+    void* contextNative = context->GetNativePtr();
+
+    // Recreate feature on params change (or after failed creation)
+    if (params != feature.Params || !feature.Handle)
+    {
+        const double createStartTime = Platform::GetTimeSeconds();
+        if (feature.Handle)
+        {
+            _releasedFeatures.Add({ feature.Handle, Engine::FrameCount });
+            feature.Handle = nullptr;
+        }
+        feature.Params = NGXParams();
         NVSDK_NGX_DLSS_Create_Params createParams;
         Platform::MemoryClear(&createParams, sizeof(createParams));
         createParams.Feature.InWidth = params.SrcSize.X;
         createParams.Feature.InHeight = params.SrcSize.Y;
         createParams.Feature.InTargetWidth = params.DstSize.X;
         createParams.Feature.InTargetHeight = params.DstSize.Y;
-        createParams.Feature.InPerfQualityValue = GetQuality(quality);
+        createParams.Feature.InPerfQualityValue = GetQuality(params.Quality);
         createParams.InFeatureCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_IsHDR;
         createParams.InFeatureCreateFlags |= params.UseSharpness ? NVSDK_NGX_DLSS_Feature_Flags_DoSharpening : 0;
         createParams.InFeatureCreateFlags |= NVSDK_NGX_DLSS_Feature_Flags_AutoExposure;
-        switch (_rendererType)
-        {
-        case RendererType::DirectX11:
-            if (!_parametersObject)
-                NVSDK_NGX_D3D11_AllocateParameters(&_parametersObject);
-            result = NGX_D3D11_CREATE_DLSS_EXT((ID3D11DeviceContext*)contextNative, &_paramsHandle, _parametersObject, &createParams);
-            break;
-        case RendererType::DirectX12:
-            if (!_parametersObject)
-                NVSDK_NGX_D3D12_AllocateParameters(&_parametersObject);
-            result = NGX_D3D12_CREATE_DLSS_EXT((ID3D12GraphicsCommandList*)contextNative, 1, 1, &_paramsHandle, _parametersObject, &createParams);
-            break;
-#if GRAPHICS_API_VULKAN
-        case RendererType::Vulkan:
-            if (!_parametersObject)
-                NVSDK_NGX_VULKAN_AllocateParameters(&_parametersObject);
-            result = NGX_VULKAN_CREATE_DLSS_EXT((VkCommandBuffer)contextNative, 1, 1, &_paramsHandle, _parametersObject, &createParams);
-            break;
-#endif
-        }
+        createParams.InFeatureCreateFlags |= EnumHasAnyFlags(params.MotionVectorsFlags, DLSSMotionVectorsFlags::DisplayResolution) ? 0 : NVSDK_NGX_DLSS_Feature_Flags_MVLowRes;
+        createParams.InFeatureCreateFlags |= EnumHasAnyFlags(params.MotionVectorsFlags, DLSSMotionVectorsFlags::Jittered) ? NVSDK_NGX_DLSS_Feature_Flags_MVJittered : 0;
+        createParams.InFeatureCreateFlags |= EnumHasAnyFlags(params.MotionVectorsFlags, DLSSMotionVectorsFlags::InvertedDepth) ? NVSDK_NGX_DLSS_Feature_Flags_DepthInverted : 0;
+        if (!_parametersObject)
+            Backend::AllocateParameters(&_parametersObject);
+        result = Backend::CreateFeature(contextNative, &feature.Handle, _parametersObject, &createParams);
         if (NVSDK_NGX_FAILED(result))
         {
             LOG(Error, "Failed to create params. Error code: 0x{:x}, {}", (uint32)result, GetNGXResultAsString(result));
+            feature.Handle = nullptr;
             return;
         }
+        feature.Params = params;
+        _stats.CreateTimeMs = (float)((Platform::GetTimeSeconds() - createStartTime) * 1000.0);
+        unsigned long long memoryUsage = 0;
+        NGX_DLSS_GET_STATS(_parametersObject, &memoryUsage);
+        _stats.MemoryUsage = (uint64)memoryUsage;
     }
 
-    // Put resources into proper state
-    switch (_rendererType)
-    {
-    case RendererType::DirectX12:
-        context->SetResourceState(output, 0x8); // D3D12_RESOURCE_STATE_UNORDERED_ACCESS
-        context->SetResourceState(input, 0x40 | 0x80); // D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-        context->SetResourceState(renderContext.Task->Buffers->DepthBuffer, 0x40 | 0x80); // D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-        if (renderContext.Task->Buffers->MotionVectors)
-            context->SetResourceState(renderContext.Task->Buffers->MotionVectors, 0x40 | 0x80); // D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE
-        break;
-    }
+    // Setup evaluation params (NGX helper copies all of them into the parameters object on every call, so there is nothing to gain from caching them)
+    const double startTime = Platform::GetTimeSeconds(); // exclude feature creation from the evaluation time
+    typename Backend::EvalParams evalParams;
+    typename Backend::ResourceSlot output, color, depth, motionVectors, reactiveMask;
+    Platform::MemoryClear(&evalParams, sizeof(evalParams));
+    evalParams.Feature.pInOutput = output.Get(inputs.Output);
+    evalParams.Feature.pInColor = color.Get(inputs.Color);
+    evalParams.pInDepth = depth.Get(inputs.Depth);
+    evalParams.pInMotionVectors = motionVectors.Get(inputs.MotionVectors);
+    evalParams.pInBiasCurrentColorMask = reactiveMask.Get(inputs.ReactiveMask);
+    evalParams.InRenderSubrectDimensions.Width = inputs.RenderSize.X;
+    evalParams.InRenderSubrectDimensions.Height = inputs.RenderSize.Y;
+    evalParams.Feature.InSharpness = inputs.Sharpness;
+    evalParams.InJitterOffsetX = inputs.Jitter.X;
+    evalParams.InJitterOffsetY = inputs.Jitter.Y;
+    evalParams.InMVScaleX = inputs.MotionVectorsScale.X;
+    evalParams.InMVScaleY = inputs.MotionVectorsScale.Y;
+    evalParams.InReset = inputs.Reset ? 1 : 0;
+    evalParams.InFrameTimeDeltaInMsec = inputs.FrameTimeDeltaMs;
 
     // Sync cached state with backend
+    Backend::PreEvaluate(context, inputs);
     context->FlushState();
 
-    // Evaluate DLSS
-    switch (_rendererType)
+    result = Backend::Evaluate(contextNative, feature.Handle, _parametersObject, &evalParams);
+    Backend::PostEvaluate(context);
+    if (NVSDK_NGX_FAILED(result))
     {
-    case RendererType::DirectX11:
-        {
-            NVSDK_NGX_D3D11_DLSS_Eval_Params evalParams;
-            Platform::MemoryClear(&evalParams, sizeof(evalParams));
-            evalParams.Feature.pInOutput = (ID3D11Resource*)output->GetNativePtr();
-            evalParams.Feature.pInColor = (ID3D11Resource*)input->GetNativePtr();
-            evalParams.pInDepth = (ID3D11Resource*)renderContext.Task->Buffers->DepthBuffer->GetNativePtr();
-            evalParams.pInMotionVectors = renderContext.Task->Buffers->MotionVectors ? (ID3D11Resource*)renderContext.Task->Buffers->MotionVectors->GetNativePtr() : nullptr;
-            evalParams.InRenderSubrectDimensions.Width = params.SrcSize.X;
-            evalParams.InRenderSubrectDimensions.Height = params.SrcSize.Y;
-            evalParams.pInExposureTexture = nullptr;
-            evalParams.InPreExposure = 0.0f;
-            evalParams.Feature.InSharpness = sharpness;
-            evalParams.InJitterOffsetX = pixelOffset.X;
-            evalParams.InJitterOffsetY = pixelOffset.Y;
-            evalParams.InMVScaleX = (float)params.SrcSize.X; // scale motion vectors from normalized [-1;1] to pixel-space
-            evalParams.InMVScaleY = (float)params.SrcSize.Y;
-            //evalParams.InMVScaleX = 1.0f;
-            //evalParams.InMVScaleY = 1.0f;
-            evalParams.InReset = renderContext.Task->IsCameraCut;
-            evalParams.InFrameTimeDeltaInMsec = (float)Time::Draw.UnscaledDeltaTime.GetTotalMilliseconds();
-            result = NGX_D3D11_EVALUATE_DLSS_EXT((ID3D11DeviceContext*)contextNative, _paramsHandle, _parametersObject, &evalParams);
-            break;
-        }
-    case RendererType::DirectX12:
+        LOG(Error, "Failed to evaluate DLSS. Error code: 0x{:x}, {}", (uint32)result, GetNGXResultAsString(result));
+        return;
+    }
+    context->ClearState();
+    _stats.EvaluateTimeMs = (float)((Platform::GetTimeSeconds() - startTime) * 1000.0);
+}
+
+template<typename Backend>
+void NGXWrapper::ReleaseFeatures(bool all)
+{
+    // Release features of render tasks that no longer use DLSS
+    for (auto it = _features.Begin(); it.IsNotEnd(); ++it)
+    {
+        if (all || Engine::FrameCount - it->Value.LastUsedFrame >= NGX_FEATURE_UNUSED_FRAMES)
         {
-            NVSDK_NGX_D3D12_DLSS_Eval_Params evalParams;
-            Platform::MemoryClear(&evalParams, sizeof(evalParams));
-            evalParams.Feature.pInOutput = (ID3D12Resource*)output->GetNativePtr();
-            evalParams.Feature.pInColor = (ID3D12Resource*)input->GetNativePtr();
-            evalParams.pInDepth = (ID3D12Resource*)renderContext.Task->Buffers->DepthBuffer->GetNativePtr();
-            evalParams.pInMotionVectors = renderContext.Task->Buffers->MotionVectors ? (ID3D12Resource*)renderContext.Task->Buffers->MotionVectors->GetNativePtr() : nullptr;
-            evalParams.InRenderSubrectDimensions.Width = params.SrcSize.X;
-            evalParams.InRenderSubrectDimensions.Height = params.SrcSize.Y;
-            evalParams.pInExposureTexture = nullptr;
-            evalParams.InPreExposure = 0.0f;
-            evalParams.Feature.InSharpness = sharpness;
-            evalParams.InJitterOffsetX = pixelOffset.X;
-            evalParams.InJitterOffsetY = pixelOffset.Y;
-            evalParams.InMVScaleX = (float)params.SrcSize.X; // scale motion vectors from normalized [-1;1] to pixel-space
-            evalParams.InMVScaleY = (float)params.SrcSize.Y;
-            //evalParams.InMVScaleX = 1.0f;
-            //evalParams.InMVScaleY = 1.0f;
-            evalParams.InReset = renderContext.Task->IsCameraCut;
-            evalParams.InFrameTimeDeltaInMsec = (float)Time::Draw.UnscaledDeltaTime.GetTotalMilliseconds();
-            result = NGX_D3D12_EVALUATE_DLSS_EXT((ID3D12GraphicsCommandList*)contextNative, _paramsHandle, _parametersObject, &evalParams);
-
-            // Ensure that root signature and descriptor heaps are properly set after DLSS modified them
-            context->ForceRebindDescriptors();
-            break;
+            if (it->Value.Handle)
+                _releasedFeatures.Add({ it->Value.Handle, Engine::FrameCount });
+            _features.Remove(it);
         }
-#if GRAPHICS_API_VULKAN
-    case RendererType::Vulkan:
+    }
+    for (int32 i = _releasedFeatures.Count() - 1; i >= 0; i--)
+    {
+        const ReleasedFeature& e = _releasedFeatures[i];
+        if (all || Engine::FrameCount - e.Frame >= NGX_FEATURE_RELEASE_LATENCY)
         {
-            NVSDK_NGX_VK_DLSS_Eval_Params evalParams;
-            Platform::MemoryClear(&evalParams, sizeof(evalParams));
-            NVSDK_NGX_Resource_VK outputVk, inputVk, depthBufferVk, motionVectorsVk;
-            GetVulkanResource(outputVk, output, evalParams.Feature.pInOutput);
-            GetVulkanResource(inputVk, input, evalParams.Feature.pInColor);
-            GetVulkanResource(depthBufferVk, renderContext.Task->Buffers->DepthBuffer, evalParams.pInDepth);
-            GetVulkanResource(motionVectorsVk, renderContext.Task->Buffers->MotionVectors, evalParams.pInMotionVectors);
-            evalParams.InRenderSubrectDimensions.Width = params.SrcSize.X;
-            evalParams.InRenderSubrectDimensions.Height = params.SrcSize.Y;
-            evalParams.pInExposureTexture = nullptr;
-            evalParams.InPreExposure = 0.0f;
-            evalParams.Feature.InSharpness = sharpness;
-            evalParams.InJitterOffsetX = pixelOffset.X;
-            evalParams.InJitterOffsetY = pixelOffset.Y;
-            evalParams.InMVScaleX = (float)params.SrcSize.X; // scale motion vectors from normalized [-1;1] to pixel-space
-            evalParams.InMVScaleY = (float)params.SrcSize.Y;
-            //evalParams.InMVScaleX = 1.0f;
-            //evalParams.InMVScaleY = 1.0f;
-            evalParams.InReset = renderContext.Task->IsCameraCut;
-            evalParams.InFrameTimeDeltaInMsec = (float)Time::Draw.UnscaledDeltaTime.GetTotalMilliseconds();
-            result = NGX_VULKAN_EVALUATE_DLSS_EXT((VkCommandBuffer)contextNative, _paramsHandle, _parametersObject, &evalParams);
-            break;
+            const NVSDK_NGX_Result result = Backend::ReleaseFeature(e.Handle);
+            if (NVSDK_NGX_FAILED(result))
+                LOG(Warning, "Failed to release DLSS feature. Error code: 0x{:x}, {}", (uint32)result, GetNGXResultAsString(result));
+            _releasedFeatures.RemoveAt(i);
         }
-#endif
     }
-    if (NVSDK_NGX_FAILED(result))
+}
+
+void NGXWrapper::ReleaseFeature(const RenderTask* task)
+{
+    Feature feature;
+    if (_features.TryGet(task, feature))
     {
-        LOG(Error, "Failed to evaluate DLSS. Error code: 0x{:x}, {}", (uint32)result, GetNGXResultAsString(result));
-        return;
+        if (feature.Handle)
+            _releasedFeatures.Add({ feature.Handle, Engine::FrameCount });
+        _features.Remove(task);
     }
-    context->ClearState();
 }
@@ -3,10 +3,19 @@
 #include "Types.h"
 #include "Engine/Core/Types/BaseTypes.h"
 #include "Engine/Core/Math/Vector2.h"
+#include "Engine/Core/Collections/Array.h"
+#include "Engine/Core/Collections/Dictionary.h"
 #include "Engine/Graphics/RenderTask.h"
 
+// Amount of frames to wait before releasing the old DLSS feature (it can be still used by the GPU frames in flight)
+#define NGX_FEATURE_RELEASE_LATENCY 4
+
+// Amount of frames after which the DLSS feature of the render task that stopped using it gets released
+#define NGX_FEATURE_UNUSED_FRAMES 60
+
 struct NVSDK_NGX_Parameter;
 struct NVSDK_NGX_Handle;
+struct NGXEvalInputs;
 class GPUTexture;
 class GPUContext;
 
@@ -15,6 +24,7 @@ struct NGXParams
     Int2 SrcSize = Int2::Zero;
     Int2 DstSize = Int2::Zero;
     DLSSQuality Quality = DLSSQuality::Balanced;
+    DLSSMotionVectorsFlags MotionVectorsFlags = DLSSMotionVectorsFlags::None;
     bool UseSharpness = false;
 
     friend bool operator==(const NGXParams& lhs, const NGXParams& rhs)
@@ -22,6 +32,7 @@ struct NGXParams
         return lhs.SrcSize == rhs.SrcSize
             && lhs.DstSize == rhs.DstSize
             && lhs.Quality == rhs.Quality
+            && lhs.MotionVectorsFlags == rhs.MotionVectorsFlags
             && lhs.UseSharpness == rhs.UseSharpness;
     }
 
@@ -31,19 +42,62 @@ struct NGXParams
     }
 };
 
+struct NGXStats
+{
+    // CPU time spent on feature creation during the last resolve (in milliseconds). Zero if feature was reused.
+    float CreateTimeMs = 0.0f;
+    // CPU time spent on the last resolve (in milliseconds).
+    float EvaluateTimeMs = 0.0f;
+    // GPU memory allocated by the feature (in bytes).
+    uint64 MemoryUsage = 0;
+};
+
 class NGXWrapper
 {
 private:
+    struct Feature
+    {
+        NGXParams Params;
+        NVSDK_NGX_Handle* Handle = nullptr;
+        uint64 LastUsedFrame = 0;
+    };
+
+    struct ReleasedFeature
+    {
+        NVSDK_NGX_Handle* Handle;
+        uint64 Frame;
+    };
+
     bool _initialized = false;
+    bool _standIn = false;
     RendererType _rendererType;
     NVSDK_NGX_Parameter* _capabilityParameters = nullptr;
-    NGXParams _params;
-    NVSDK_NGX_Handle* _paramsHandle = nullptr;
     NVSDK_NGX_Parameter* _parametersObject = nullptr;
+    Dictionary<const RenderTask*, Feature> _features;
+    Array<ReleasedFeature> _releasedFeatures;
+    NGXStats _stats;
 
 public:
     bool Initialize(uint32 appId, const StringAnsi& projectId, DLSSSupport& support);
+    bool InitializeStandIn(DLSSSupport& support);
     void Shutdown();
     void QueryRecommendedSettings(const Int2& displaySize, DLSSRecommendedSettings& output, DLSSQuality quality) const;
-    void TemporalResolve(GPUContext* context, RenderContext& renderContext, GPUTexture* input, GPUTexture* output, DLSSQuality quality, const Float2& pixelOffset, float sharpness);
+    void TemporalResolve(GPUContext* context, RenderContext& renderContext, GPUTexture* input, GPUTexture* output, GPUTexture* motionVectors, GPUTexture* reactiveMask, DLSSQuality quality, DLSSMotionVectorsFlags motionVectorsFlags, const Float2& pixelOffset, float sharpness);
+    void ReleaseFeature(const RenderTask* task);
+
+    bool IsStandIn() const
+    {
+        return _standIn;
+    }
+
+    const NGXStats& GetStats() const
+    {
+        return _stats;
+    }
+
+private:
+    template<typename Backend>
+    void Evaluate(GPUContext* context, Feature& feature, const NGXParams& params, const NGXEvalInputs& inputs);
+    template<typename Backend>
+    void ReleaseFeatures(bool all);
 };
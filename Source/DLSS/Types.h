@@ -1,7 +1,9 @@
 ﻿#pragma once
 
 #include "Engine/Core/Types/BaseTypes.h"
+#include "Engine/Core/Types/String.h"
 #include "Engine/Core/Math/Vector2.h"
+#include "Engine/Core/Collections/Array.h"
 
 /// <summary>
 /// DLSS support modes.
@@ -41,6 +43,72 @@ API_ENUM(Namespace="NVIDIA") enum class DLSSQuality
     MAX
 };
 
+/// <summary>
+/// DLSS motion vectors and depth buffer input description flags.
+/// </summary>
+API_ENUM(Namespace="NVIDIA", Attributes="System.Flags") enum class DLSSMotionVectorsFlags
+{
+    // Motion vectors are at render resolution and don't include camera jitter (default engine motion vectors).
+    None = 0,
+    // Motion vectors are at display (output) resolution. Requires custom motion vectors texture of the output size.
+    DisplayResolution = 1,
+    // Motion vectors include the camera jitter offset.
+    Jittered = 2,
+    // Depth buffer uses inverted range (1 at near plane, 0 at far plane).
+    InvertedDepth = 4,
+};
+
+DECLARE_ENUM_OPERATORS(DLSSMotionVectorsFlags);
+
+/// <summary>
+/// Types of the render tasks that can use DLSS.
+/// </summary>
+API_ENUM(Namespace="NVIDIA", Attributes="System.Flags") enum class DLSSRenderTaskTypes
+{
+    // No render tasks.
+    None = 0,
+    // Main game render task.
+    Main = 1,
+    // Custom scene render tasks (eg. camera rendering to texture, editor viewports).
+    Custom = 2,
+    // Offline rendering passes (eg. environment probes capture, lightmaps baking).
+    Offline = 4,
+    // Single-frame rendering passes (eg. editor asset thumbnails and previews caching).
+    SingleFrame = 8,
+    // All render tasks.
+    All = Main | Custom | Offline | SingleFrame,
+};
+
+DECLARE_ENUM_OPERATORS(DLSSRenderTaskTypes);
+
+/// <summary>
+/// DLSS usage mode override for the render task.
+/// </summary>
+API_ENUM(Namespace="NVIDIA") enum class DLSSRenderTaskMode
+{
+    // Use the render task policy to decide whether to use DLSS.
+    Default,
+    // Always use DLSS for the render task (if supported).
+    Enabled,
+    // Never use DLSS for the render task.
+    Disabled,
+
+    MAX
+};
+
+/// <summary>
+/// DLSS render task policy that decides which render tasks can use DLSS.
+/// </summary>
+API_STRUCT(Namespace="NVIDIA") struct DLSS_API DLSSRenderTaskPolicy
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(DLSSRenderTaskPolicy);
+
+    // Types of the render tasks that can use DLSS. Other tasks are rendered without DLSS.
+    API_FIELD() DLSSRenderTaskTypes Types = DLSSRenderTaskTypes::Main | DLSSRenderTaskTypes::Custom;
+    // Minimum output size (in pixels) of the render task to use DLSS. Smaller views are rendered without DLSS.
+    API_FIELD() Int2 MinOutputSize = Int2(256, 256);
+};
+
 /// <summary>
 /// DLSS optimal settings descriptor.
 /// </summary>
@@ -57,3 +125,26 @@ API_STRUCT(Namespace="NVIDIA") struct DLSS_API DLSSRecommendedSettings
     // Optimal sharpness parameter value.
     API_FIELD() float Sharpness;
 };
+
+/// <summary>
+/// DLSS benchmark settings.
+/// </summary>
+API_STRUCT(Namespace="NVIDIA") struct DLSS_API DLSSBenchmarkSettings
+{
+    DECLARE_SCRIPTING_TYPE_MINIMAL(DLSSBenchmarkSettings);
+
+    // Output (display) resolutions to test. Empty to use default list (720p, 1080p, 1440p, 2160p).
+    API_FIELD() Array<Int2> Resolutions;
+    // Amount of frames to skip (not recorded) after switching quality mode or resolution.
+    API_FIELD() int32 WarmupFrames = 30;
+    // Amount of frames to record for each quality mode and resolution.
+    API_FIELD() int32 Frames = 120;
+    // Radius of the circular camera path around the main camera location (in world units).
+    API_FIELD() float CameraPathRadius = 200.0f;
+    // Output file path (without extension) for CSV and JSON results. Empty to use 'DLSSBenchmark' in project folder.
+    API_FIELD() String OutputPath;
+    // If checked, benchmark will run against stand-in backend instead of NGX (eg. for testing on GPU-less CI). Stand-in is used always when running with Null renderer.
+    API_FIELD() bool UseStandIn = false;
+    // If checked, engine will exit once benchmark ends.
+    API_FIELD() bool ExitOnEnd = false;
+};
@@ -0,0 +1,31 @@
+﻿using Flax.Build;
+using Flax.Build.NativeCpp;
+
+public class DLSSBenchmarkTarget : GameProjectTarget
+{
+    /// <inheritdoc />
+    public override void Init()
+    {
+        base.Init();
+
+        Platforms = new[]
+        {
+            TargetPlatform.Windows,
+            TargetPlatform.Linux,
+        };
+        Architectures = new[]
+        {
+            TargetArchitecture.x64,
+        };
+        Modules.Add("DLSS");
+    }
+
+    /// <inheritdoc />
+    public override void SetupTargetEnvironment(BuildOptions options)
+    {
+        base.SetupTargetEnvironment(options);
+
+        // Run DLSS benchmark on startup and exit when done
+        options.CompileEnv.PreprocessorDefinitions.Add("DLSS_BENCHMARK");
+    }
+}
@@ -0,0 +1,27 @@
+﻿#include "./Flax/Common.hlsl"
+
+META_CB_BEGIN(0, Data)
+float ReactiveScale;
+float ReactiveThreshold;
+float2 Dummy0;
+META_CB_END
+
+Texture2D OpaqueColor : register(t0);
+Texture2D Color : register(t1);
+
+float3 Tonemap(float3 color)
+{
+    return color / (1.0f + max(max(color.r, color.g), color.b));
+}
+
+// Pixel shader that generates DLSS reactive mask (bias current color) from the difference between opaque-only and final scene color
+META_PS(true, FEATURE_LEVEL_SM5)
+float PS_ReactiveMask(Quad_VS2PS input) : SV_Target
+{
+    int3 pixel = int3(input.Position.xy, 0);
+    float3 opaque = Tonemap(OpaqueColor.Load(pixel).rgb);
+    float3 color = Tonemap(Color.Load(pixel).rgb);
+    float3 delta = abs(color - opaque);
+    float reactive = max(delta.r, max(delta.g, delta.b));
+    return reactive > ReactiveThreshold ? saturate(reactive * ReactiveScale) : 0.0f;
+}